@@ -13,21 +13,79 @@
 #include <unordered_set>
 #include <set>
 #include <chrono>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+#include <stdexcept>
 
 std::mt19937 generator(std::chrono::steady_clock::now().time_since_epoch().count());
 std::uniform_int_distribution<int64_t> prior(0, 1e15);
 
+// compile-time parameters of the structure
+
+/*
+    VertexId - unsigned type of vertex ids (uint16_t / uint32_t / uint64_t),
+    the largest value of VertexId is reserved as "no vertex"
+    MaxLevel - maximal level of an edge, levels never exceed ceil(log2 n),
+    so MaxLevel = digits of VertexId is always enough
+    Level - type of level stored in every node (loops have level -1)
+    SubtreeSize - type of subtree size, euler tour has less than 3n nodes
+
+    memory on 64-bit targets (before with int ids: Node 56, map_edges entry 16,
+    edge level entry 12 bytes):
+    uint16_t - Node 48, map_edges entry 16, edge level entry 6
+    uint32_t - Node 56, map_edges entry 16, edge level entry 12
+    uint64_t - Node 64, map_edges entry 24, edge level entry 24
+    only uint16_t saves memory, wider ids trade it for more vertices;
+    keys stay pairs, packing them into one integer would not shrink these
+*/
+
+template <typename VertexId>
+constexpr VertexId kNoVertex = std::numeric_limits<VertexId>::max();
+
+using Level = int8_t;
+
+template <typename VertexId>
+using SubtreeSize = std::conditional_t<(sizeof(VertexId) < sizeof(uint32_t)),
+                                       uint32_t, uint64_t>;
+
+constexpr int ceil_log2(std::size_t nn) {
+    int result = 0;
+    while (result < std::numeric_limits<std::size_t>::digits &&
+           (static_cast<std::size_t>(1) << result) < nn) {
+        ++result;
+    }
+    return result;
+}
+
 // dynamic euler tour tree using treaps with implicit keys
 
+template <typename VertexId>
 struct hash {
-    int64_t operator()(const std::pair<int, int>& p) const {
-        return static_cast<int64_t>((static_cast<int64_t>(p.first) << 20) ^ p.second);
+    std::size_t operator()(const std::pair<VertexId, VertexId>& p) const {
+        // pack u-v into one word when it fits, otherwise mix the halves
+        if constexpr (2 * sizeof(VertexId) <= sizeof(uint64_t)) {
+            uint64_t packed = (static_cast<uint64_t>(p.first)
+                               << std::numeric_limits<VertexId>::digits) | p.second;
+            return std::hash<uint64_t>()(packed);
+        } else {
+            uint64_t mixed = static_cast<uint64_t>(p.first) * 0x9E3779B97F4A7C15ULL;
+            return std::hash<uint64_t>()(mixed ^ static_cast<uint64_t>(p.second));
+        }
     }
 };
 
 
+template <typename VertexId, int MaxLevel>
 struct Node {
 
+    static_assert(std::is_unsigned<VertexId>::value, "vertex id must be unsigned");
+    static_assert(MaxLevel >= 0 && MaxLevel <= std::numeric_limits<Level>::max(),
+                  "level must fit into Level");
+
     /*
         key - edge u-v
         size - size of subtree
@@ -43,13 +101,13 @@ struct Node {
         left, right, parent - pointers to left subtree / right subtree / parent
     */
 
-    std::pair<int, int> key;
-    int size;
+    std::pair<VertexId, VertexId> key;
+    SubtreeSize<VertexId> size;
+    Level level;
     bool size_of_min_level;
     bool size_of_adjacent;
     bool is_min_level;
     bool is_has_adjacent;
-    int level;
     int64_t priority;
     Node* left;
     Node* right;
@@ -64,7 +122,7 @@ struct Node {
         level = 0;
     }
 
-    Node(std::pair<int, int> key, int64_t priority, int lvl)
+    Node(std::pair<VertexId, VertexId> key, int64_t priority, int lvl)
         : key(key),
           priority(priority),
           left(nullptr),
@@ -75,38 +133,43 @@ struct Node {
         size_of_min_level = false;
         is_min_level = false;
         is_has_adjacent = false;
-        level = lvl;
+        level = static_cast<Level>(lvl);
     }
 };
 
-inline int get_size(Node* root) {
+template <typename TNode>
+inline std::size_t get_size(TNode* root) {
     if (root == nullptr) {
         return 0;
     }
     return root->size;
 }
 
-inline bool get_size_min_level(Node* root) {
+template <typename TNode>
+inline bool get_size_min_level(TNode* root) {
     if (root == nullptr) {
         return 0;
     }
     return root->size_of_min_level;
 }
 
-inline bool get_size_adjacent(Node* root) {
+template <typename TNode>
+inline bool get_size_adjacent(TNode* root) {
     if (root == nullptr) {
         return 0;
     }
     return root->size_of_adjacent;
 }
 
-inline void update_size(Node* root) {
+template <typename TNode>
+inline void update_size(TNode* root) {
     if (root) {
         root->size = get_size(root->left) + get_size(root->right) + 1;
     }
 }
 
-inline void update_size_flag(Node* root) {
+template <typename TNode>
+inline void update_size_flag(TNode* root) {
     if (root) {
         root->size_of_min_level = (get_size_min_level(root->left) |
                                   get_size_min_level(root->right) |
@@ -117,15 +180,17 @@ inline void update_size_flag(Node* root) {
     }
 }
 
-inline void update_up(Node* root) {
+template <typename TNode>
+inline void update_up(TNode* root) {
     update_size_flag(root);
     if (root->parent) {
         update_up(root->parent);
     }
 }
 
-inline void split(Node* root, int key,
-           Node*& left, Node*& right) {
+template <typename TNode>
+inline void split(TNode* root, std::size_t key,
+           TNode*& left, TNode*& right) {
     if (root == nullptr) {
         left = nullptr;
         right = nullptr;
@@ -156,7 +221,8 @@ inline void split(Node* root, int key,
     update_size_flag(right);
 }
 
-inline void merge(Node*& root, Node* left, Node* right) {
+template <typename TNode>
+inline void merge(TNode*& root, TNode* left, TNode* right) {
     if (left == nullptr) {
         root = right;
         if (root) {
@@ -192,7 +258,8 @@ inline void merge(Node*& root, Node* left, Node* right) {
     update_size_flag(root);
 }
 
-inline Node* lift(Node* root) {
+template <typename TNode>
+inline TNode* lift(TNode* root) {
     while (root && root->parent) {
         root = root->parent;
     }
@@ -201,8 +268,9 @@ inline Node* lift(Node* root) {
 
 // finds implicit key
 
-inline void get_normal_key(Node* parent,
-                           Node* start_loop, int& result) {
+template <typename TNode>
+inline void get_normal_key(TNode* parent,
+                           TNode* start_loop, std::size_t& result) {
     if (!parent) {
         return;
     }
@@ -214,12 +282,14 @@ inline void get_normal_key(Node* parent,
 
 // reroot euler tour tree (helpful function for merging / spliting two ETT)
 
-inline void reroot(Node*& root, int start, int end,
-            std::unordered_map<std::pair<int, int>, Node*, hash>& map_edges) {
+template <typename VertexId, int MaxLevel>
+inline void reroot(Node<VertexId, MaxLevel>*& root, VertexId start, VertexId end,
+            std::unordered_map<std::pair<VertexId, VertexId>,
+                               Node<VertexId, MaxLevel>*, hash<VertexId>>& map_edges) {
     auto start_loop = map_edges[{start, end}];
-    int key = get_size(start_loop->left);
+    std::size_t key = get_size(start_loop->left);
     get_normal_key(start_loop->parent, start_loop, key);
-    Node* first = nullptr;
+    Node<VertexId, MaxLevel>* first = nullptr;
     split(root, key, root, first);
     merge(root, first, root);
 }
@@ -229,6 +299,7 @@ inline void reroot(Node*& root, int start, int end,
    is spanning tree consisting of edges u-v such that level(u-v) <= i
 */
 
+template <typename VertexId, int MaxLevel>
 struct DynamicForest {
 
     /*
@@ -239,14 +310,17 @@ struct DynamicForest {
         level - level of DynamicForest
     */
 
-    std::unordered_map<std::pair<int, int>, Node*, hash> map_edges;
-    std::unordered_map<int, std::unordered_set<int>> adjacent_edges;
+    using NodeType = Node<VertexId, MaxLevel>;
+
+    std::unordered_map<std::pair<VertexId, VertexId>, NodeType*, hash<VertexId>> map_edges;
+    std::unordered_map<VertexId, std::unordered_set<VertexId>> adjacent_edges;
     int level;
-    DynamicForest(int nn, int level) : level(level) {
-        for (int i = 0; i < nn; ++i) {
+    DynamicForest(std::size_t nn, int level) : level(level) {
+        for (std::size_t i = 0; i < nn; ++i) {
+            VertexId id = static_cast<VertexId>(i);
             int64_t value = prior(generator);
-            Node* it = new Node({i, i}, value, -1);
-            map_edges[{i, i}] = it;
+            NodeType* it = new NodeType({id, id}, value, -1);
+            map_edges[{id, id}] = it;
         }
     }
 
@@ -256,20 +330,20 @@ struct DynamicForest {
         }
     }
 
-    bool is_connected(int uu, int vv) {
+    bool is_connected(VertexId uu, VertexId vv) {
         return lift(map_edges[{uu, uu}]) == lift(map_edges[{vv, vv}]);
     }
 
-    void add_edge(int uu, int vv, int lvl) {
+    void add_edge(VertexId uu, VertexId vv, int lvl) {
         auto left = lift(map_edges[{uu, uu}]);
         reroot(left, uu, uu, map_edges);
         auto right = lift(map_edges[{vv, vv}]);
         reroot(right, vv, vv, map_edges);
         int64_t value = prior(generator);
-        Node* to = new Node({uu, vv}, value, lvl);
+        NodeType* to = new NodeType({uu, vv}, value, lvl);
         to->is_min_level = (level == to->level && uu < vv); // u < v is important
         value = prior(generator);
-        Node* from = new Node({vv, uu}, value, lvl);
+        NodeType* from = new NodeType({vv, uu}, value, lvl);
         from->is_min_level = (level == from->level && vv < uu); // u < v is important
         map_edges[{uu, vv}] = to;
         map_edges[{vv, uu}] = from;
@@ -278,17 +352,17 @@ struct DynamicForest {
         merge(left, left, from);
     }
 
-    void delete_edge(int uu, int vv) {
+    void delete_edge(VertexId uu, VertexId vv) {
         auto treap = lift(map_edges[{uu, vv}]);
         reroot(treap, uu, vv, map_edges);
-        Node* temporary = nullptr;
+        NodeType* temporary = nullptr;
         split(treap, 1, temporary, treap);
         auto vu = map_edges[{vv, uu}];
-        int key = get_size(vu->left);
+        std::size_t key = get_size(vu->left);
         get_normal_key(vu->parent, vu, key);
-        Node* left_first = nullptr;
+        NodeType* left_first = nullptr;
         split(treap, key, left_first, treap);
-        Node* left_second = nullptr;
+        NodeType* left_second = nullptr;
         split(treap, 1, left_second, treap);
         delete vu;
         delete temporary;
@@ -299,37 +373,52 @@ struct DynamicForest {
 
 // graph G_{i} (as in article)
 
+template <typename VertexId = uint32_t,
+          int MaxLevel = std::numeric_limits<VertexId>::digits>
 class DynamicGraph {
 public:
     /*
         mx_level - maximal level across all edges
         n_ - number of vertices
-        spanning_trees - vector of pointers to different DynamicForests
+        spanning_trees - fixed array of pointers to different DynamicForests
+        (forest of level i is built when the first edge reaches level i)
         spanning_edges_levels - map to store levels of spanning tree edges
         not_spanning_edges_levels - map to store levels of non-spanning tree edges
     */
 
-    int mx_level = 0;
-    int n_;
-    int components;
-    std::vector<std::unique_ptr<DynamicForest>> spanning_trees;
-    std::unordered_map<std::pair<int, int>, int, hash> spanning_edges_levels;
-    std::unordered_map<std::pair<int, int>, int, hash> not_spanning_edges_levels;
+    using NodeType = Node<VertexId, MaxLevel>;
+    using ForestType = DynamicForest<VertexId, MaxLevel>;
+    using Edge = std::pair<VertexId, VertexId>;
 
-    explicit DynamicGraph(int nn) : n_(nn) {
+    int mx_level = 0;
+    std::size_t n_;
+    std::size_t components;
+    std::array<std::unique_ptr<ForestType>, MaxLevel + 1> spanning_trees;
+    std::unordered_map<Edge, Level, hash<VertexId>> spanning_edges_levels;
+    std::unordered_map<Edge, Level, hash<VertexId>> not_spanning_edges_levels;
+
+    explicit DynamicGraph(std::size_t nn) : n_(nn) {
+        // the last id is reserved as "no vertex", levels are bounded by ceil(log2 n)
+        if (nn > static_cast<std::size_t>(kNoVertex<VertexId>)) {
+            throw std::length_error("number of vertices does not fit into VertexId");
+        }
+        if (ceil_log2(nn) > MaxLevel) {
+            throw std::invalid_argument("ceil(log2 n) exceeds MaxLevel");
+        }
         components = nn;
         build();
     }
 
     void build(int level = 0) {
-        if (level == static_cast<int>(spanning_trees.size())) {
-            spanning_trees.emplace_back(new DynamicForest(n_, level));
+        assert(level <= MaxLevel);
+        if (!spanning_trees[level]) {
+            spanning_trees[level].reset(new ForestType(n_, level));
         }
     }
 
     // add edge (as in article)
 
-    void AddEdge(int u_, int v_) {
+    void AddEdge(VertexId u_, VertexId v_) {
         bool connected = spanning_trees[0]->is_connected(u_, v_);
         if (connected) {
             not_spanning_edges_levels[{u_, v_}] = 0;
@@ -358,7 +447,7 @@ public:
     // in article, we should increase level of every edge that 
     // is not suitable but that we have visited
 
-    void IncreaseLevel(Node* root) {
+    void IncreaseLevel(NodeType* root) {
         if (!root) {
             return;
         }
@@ -368,10 +457,8 @@ public:
                 auto key = root->key;
                 int new_level = root->level + 1;
                 mx_level = std::max(mx_level, new_level);
-                if (new_level == static_cast<int>(spanning_trees.size())) {
-                    build(new_level);
-                }
-                int u_ = key.first, v_ = key.second;
+                build(new_level);
+                VertexId u_ = key.first, v_ = key.second;
                 spanning_trees[new_level]->add_edge(u_, v_, new_level);
                 ++spanning_edges_levels[{u_, v_}];
                 ++spanning_edges_levels[{v_, u_}];
@@ -386,18 +473,19 @@ public:
 
     // walk around treap and visit only good nodes (nodes where we can find important edges)
 
-    void BruteforceAdjacentEdges(Node* root,
-                                 std::pair<int, int>& result, int level) {
+    void BruteforceAdjacentEdges(NodeType* root,
+                                 Edge& result, int level) {
+        const Edge none = {kNoVertex<VertexId>, kNoVertex<VertexId>};
         if (!root) {
             return;
         }
-        if (result != std::make_pair(-1, -1)) {
+        if (result != none) {
             return;
         }
         if (get_size_adjacent(root)) {
             if (root->is_has_adjacent) {
-                int u_ = root->key.first;
-                std::vector<int> to_delete;
+                VertexId u_ = root->key.first;
+                std::vector<VertexId> to_delete;
                 for (auto to : spanning_trees[level]->adjacent_edges[u_]) {
                     if (spanning_trees[0]->is_connected(to, u_)) {
                         to_delete.emplace_back(to);
@@ -420,9 +508,7 @@ public:
                 for (auto to : to_delete) {
                     int new_level = level + 1;
                     mx_level = std::max(mx_level, new_level);
-                    if (new_level == static_cast<int>(spanning_trees.size())) {
-                        build(new_level);
-                    }
+                    build(new_level);
                     spanning_trees[level]->adjacent_edges[u_].erase(to);
                     spanning_trees[level]->adjacent_edges[to].erase(u_);
                     spanning_trees[new_level]->adjacent_edges[u_].insert(to);
@@ -460,21 +546,22 @@ public:
 
     // finds new edge from not spanning edges that can replace deleted one
 
-    void FindNewEdge(int u_, int v_, int level, bool& okay) {
+    void FindNewEdge(VertexId u_, VertexId v_, int level, bool& okay) {
         if (okay) {
             return;
         }
-        Node* u_pointer = spanning_trees[level]->map_edges[{u_, u_}];
-        Node* v_pointer = spanning_trees[level]->map_edges[{v_, v_}];
+        NodeType* u_pointer = spanning_trees[level]->map_edges[{u_, u_}];
+        NodeType* v_pointer = spanning_trees[level]->map_edges[{v_, v_}];
         u_pointer = lift(u_pointer);
         v_pointer = lift(v_pointer);
         if (get_size(u_pointer) > get_size(v_pointer)) {
             std::swap(u_pointer, v_pointer);
         }
         IncreaseLevel(u_pointer);
-        std::pair<int, int> result = {-1, -1};
+        const Edge none = {kNoVertex<VertexId>, kNoVertex<VertexId>};
+        Edge result = none;
         BruteforceAdjacentEdges(u_pointer, result, level);
-        if (result == std::make_pair(-1, -1)) {
+        if (result == none) {
             if (level == 0) {
                 return;
             } else {
@@ -482,8 +569,9 @@ public:
             }
         } else {
             okay = true;
-            spanning_edges_levels[result] = level;
-            spanning_edges_levels[std::make_pair(result.second, result.first)] = level;
+            spanning_edges_levels[result] = static_cast<Level>(level);
+            spanning_edges_levels[std::make_pair(result.second, result.first)] =
+                static_cast<Level>(level);
             not_spanning_edges_levels.erase(result);
             not_spanning_edges_levels.erase({result.second, result.first});
             for (int lvl = level; lvl >= 0; --lvl) {
@@ -494,7 +582,7 @@ public:
 
     // delete edge (as in article)
 
-    void RemoveEdge(int u_, int v_) {
+    void RemoveEdge(VertexId u_, VertexId v_) {
         if (not_spanning_edges_levels.count(std::make_pair(u_, v_))) {
             int current_level = not_spanning_edges_levels[std::make_pair(u_, v_)];
             not_spanning_edges_levels.erase({u_, v_});
@@ -529,11 +617,11 @@ public:
         return;
     }
 
-    bool IsConnected(int u_, int v_) {
+    bool IsConnected(VertexId u_, VertexId v_) {
         return spanning_trees[0]->is_connected(u_, v_);
     }
 
-    int GetComponentsNumber() const {
+    std::size_t GetComponentsNumber() const {
         return components;
     }
 
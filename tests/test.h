@@ -88,13 +88,13 @@ void RunFullGraphTest(int n) {
 
 void QUniqueEdges(int n, int q) {
     int need = q / 2;
-    std::vector<std::pair<int, int>> edges;
-    std::unordered_map<std::pair<int, int>, bool, hash> graph;
-    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::unordered_map<std::pair<uint32_t, uint32_t>, bool, hash<uint32_t>> graph;
+    std::uniform_int_distribution<uint32_t> vertex(0, n - 1);
     DynamicGraph DG = DynamicGraph(n);
     for (int i = 0; i < need; ++i) {
-        int u = vertex(generator);
-        int v = vertex(generator);
+        uint32_t u = vertex(generator);
+        uint32_t v = vertex(generator);
         while (v == u) {
             v = vertex(generator);
         }
@@ -112,3 +112,70 @@ void QUniqueEdges(int n, int q) {
         DG.RemoveEdge(u, v);
     }
 }
+
+// checks narrow / wide vertex ids against a simple recount of components
+
+template <typename VertexId, int MaxLevel>
+void RunIdWidthTest(int n, int q) {
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_int_distribution<int> typo(0, 1);
+    DynamicGraph<VertexId, MaxLevel> DG(n);
+    std::set<std::pair<int, int>> graph;
+    for (int i = 0; i < q; ++i) {
+        int u = vertex(generator);
+        int v = vertex(generator);
+        while (v == u) {
+            v = vertex(generator);
+        }
+        if (u > v) {
+            std::swap(u, v);
+        }
+        if (typo(generator) == 0) {
+            if (graph.insert(std::make_pair(u, v)).second) {
+                DG.AddEdge(u, v);
+            }
+        } else if (graph.erase(std::make_pair(u, v))) {
+            DG.RemoveEdge(u, v);
+        }
+        std::vector<int> root(n);
+        for (int j = 0; j < n; ++j) {
+            root[j] = j;
+        }
+        auto find = [&root](int x) {
+            while (root[x] != x) {
+                x = root[x] = root[root[x]];
+            }
+            return x;
+        };
+        std::size_t comps = n;
+        for (auto [a, b] : graph) {
+            if (find(a) != find(b)) {
+                root[find(a)] = find(b);
+                --comps;
+            }
+        }
+        if (DG.GetComponentsNumber() != comps || DG.GetMax() > MaxLevel) {
+            std::cout << "wrong answer" << '\n';
+            return;
+        }
+    }
+    // packed hash keeps u-v and v-u apart
+    if (hash<VertexId>()({0, 1}) == hash<VertexId>()({1, 0})) {
+        std::cout << "wrong hash" << '\n';
+    }
+    // the last id is reserved as "no vertex"
+    if constexpr (sizeof(VertexId) < sizeof(std::size_t)) {
+        try {
+            DynamicGraph<VertexId, MaxLevel> too_big(
+                static_cast<std::size_t>(kNoVertex<VertexId>) + 1);
+            std::cout << "wrong size check" << '\n';
+        } catch (const std::length_error&) {
+        }
+    }
+}
+
+void RunIdWidthTests() {
+    RunIdWidthTest<uint16_t, 16>(50, 20000);
+    RunIdWidthTest<uint16_t, 6>(64, 20000);
+    RunIdWidthTest<uint64_t, 64>(50, 20000);
+}